@@ -0,0 +1,73 @@
+//
+// Created by agent on 10/19/26.
+//
+
+#ifndef HASH_TABLE_BLOOMFILTER_HPP
+#define HASH_TABLE_BLOOMFILTER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+
+using uint256 = boost::multiprecision::uint256_t;
+
+#ifndef DEFAULT_BLOOM_BITS_PER_KEY
+#define DEFAULT_BLOOM_BITS_PER_KEY 10
+#endif
+
+#ifndef DEFAULT_BLOOM_PROBES
+#define DEFAULT_BLOOM_PROBES 7
+#endif
+
+/**
+ * Blocked bloom filter over already computed hash codes.
+ * Every key touches a single 512-bits block, so a query costs one cache line at most.
+ * It answers "definitely absent" or "maybe present"; removed keys are only forgotten on `reset`
+ */
+class bloom_filter {
+
+    static constexpr int block_words = 8;                       ///< 64-bits words in a block
+    static constexpr int block_bits = 64 * block_words;         ///< Bits in a block
+
+    int probes;                     ///< Number of bits set per key
+    int bits_per_key;               ///< Bits reserved per expected key
+    int n_blocks;                   ///< Total number of blocks
+    std::vector<std::uint64_t> words;   ///< Bit array, `n_blocks * block_words` words long
+
+    /// Folds a hash code into a well mixed 64-bits fingerprint
+    static std::uint64_t fingerprint(const uint256 &hash_code);
+
+    /// Returns the index of the first word of the block used by `h`
+    [[nodiscard]] std::size_t block_of(std::uint64_t h) const;
+
+public:
+
+    /// Constructs a filter sized for `capacity` keys
+    explicit bloom_filter(int capacity,
+                          int bits_per_key = DEFAULT_BLOOM_BITS_PER_KEY,
+                          int probes = DEFAULT_BLOOM_PROBES);
+
+    /// Destructs a filter
+    ~bloom_filter();
+
+    /// Adds a hash code to the filter
+    void add(const uint256 &hash_code);
+
+    /// Returns `false` if the hash code was never added and `true` if it may have been
+    [[nodiscard]] bool may_contain(const uint256 &hash_code) const;
+
+    /// Clears all the bits and resizes the filter for `capacity` keys
+    void reset(int capacity);
+
+    /// Returns the number of bytes used by the bit array
+    [[nodiscard]] std::size_t memory_usage() const;
+
+    /// Returns the expected false positive rate given the current fill of the bit array
+    [[nodiscard]] double false_positive_rate() const;
+
+};
+
+
+#endif //HASH_TABLE_BLOOMFILTER_HPP
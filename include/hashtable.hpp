@@ -8,9 +8,11 @@
 #include <functional>
 #include <stdexcept>
 #include <list>
+#include <optional>
 
 #include <boost/multiprecision/cpp_int.hpp>
 
+#include "bloomfilter.hpp"
 
 using uint8 = boost::uint8_t;
 using uint256 = boost::multiprecision::uint256_t;
@@ -31,6 +33,14 @@ using uint256 = boost::multiprecision::uint256_t;
 #define DEFAULT_MAX_LOAD_FACTOR 0.75f
 #endif
 
+#ifndef DEFAULT_PREFILTER
+#define DEFAULT_PREFILTER false
+#endif
+
+#ifndef MAX_FILTER_STALE_FACTOR
+#define MAX_FILTER_STALE_FACTOR 0.5f
+#endif
+
 template<typename Printable>
 using Print = std::function<void(std::ostream &, Printable)>;
 
@@ -57,7 +67,7 @@ template<
         typename K,
         typename V,
         typename Hash = std::hash<K>,
-        typename Index = std::function<K(V)>,
+        typename Index = std::function<K(const V &)>,
         typename Equal = std::equal_to<K>,
         uint8 RehashingFactor = MINIMUM_REHASHING_FACTOR
 > requires Constraint<RehashingFactor>
@@ -74,12 +84,42 @@ public:
         /// Constructs an entry
         explicit entry(uint256 hash_code, K key, V value);
 
+        /// Constructs an entry without values
+        explicit entry(uint256 hash_code, K key);
+
         /// Destructs an entry
         ~entry();
 
     };
 
+    /// Counters and footprint of the membership prefilter
+    struct filter_stats {
+
+        long long queries;                      ///< Lookups that consulted the filter
+        long long definite_misses;              ///< Lookups answered by the filter without walking a bucket
+        long long false_positives;              ///< Lookups let through by the filter whose key was not found
+        double observed_false_positive_rate;    ///< `false_positives` over all the lookups of absent keys
+        double estimated_false_positive_rate;   ///< Expected rate given the current fill of the filter
+        std::size_t memory_usage;               ///< Bytes used by the filter
+
+    };
+
     typedef std::list<entry>::iterator EntryIterator;
+    typedef std::list<V>::iterator ValueIterator;
+
+    /// Stable reference to a stored value; invalidated only when the value, its key or the whole table is erased, or the value is moved to another key by `update`
+    struct handle {
+
+        EntryIterator entry;        ///< Entry that holds the value
+        ValueIterator value;        ///< Position of the value in the entry
+
+        /// Read-only access to the referenced value; modifications go through `update`
+        const V &operator*() const { return *value; }
+
+        /// Read-only access to the referenced value members
+        const V *operator->() const { return &*value; }
+
+    };
 
 private:
 
@@ -91,6 +131,11 @@ private:
     Equal equal;                   ///< Receives two keys and returns true if both are equal and false otherwise
     float max_load_factor;         ///< Fill threshold; when exeeded, rehashing occurs
     std::list<entry> *buckets;     ///< Pointer to the array where entry lists are located
+    std::optional<bloom_filter> filter;     ///< Membership prefilter over the stored hash codes; empty when disabled
+    int filter_stale;              ///< Keys removed since `filter` was last rebuilt; their bits are still set
+    long long filter_queries;      ///< Lookups that consulted `filter`
+    long long filter_misses;       ///< Lookups rejected by `filter`
+    long long filter_false_hits;   ///< Lookups accepted by `filter` whose key was not found
 
     ///< Returns the number of keys divided by the number of buckets
     float load_factor();
@@ -98,6 +143,24 @@ private:
     ///< Creates a new hash table and re-calculate the buckets for each entry in order to maintain the searching performance
     void rehashing();
 
+    ///< Resizes the prefilter for the current number of buckets and re-adds every stored hash code
+    void rebuild_filter();
+
+    ///< Adds a new key to the prefilter, rebuilding it instead if too many removed keys are still set
+    void filter_add(const uint256 &hash_code);
+
+    ///< Returns `true` if the prefilter guarantees that `hash_code` is not stored
+    bool filter_rejects(const uint256 &hash_code);
+
+    ///< Returns the entry of `key` in the bucket of `hash_code`, creating it if not exists, and `true` if it was created
+    std::pair<EntryIterator, bool> locate(const K &key, const uint256 &hash_code);
+
+    ///< Moves the single value of `node` to the front of `it` without copying it. Occassionaly, rehashing occurs
+    handle attach(EntryIterator it, std::list<V> &node);
+
+    ///< Removes the entry `it` if it has no values left
+    void drop_if_empty(EntryIterator it);
+
 public:
 
     /// Constructs a hash table
@@ -105,7 +168,8 @@ public:
                         Hash hash = Hash(),
                         Equal equal = Equal(),
                         int b = DEFAULT_N_BUCKETS,
-                        float max_load_factor = DEFAULT_MAX_LOAD_FACTOR);
+                        float max_load_factor = DEFAULT_MAX_LOAD_FACTOR,
+                        bool prefilter = DEFAULT_PREFILTER);
 
     /// Destructs a hash table
     ~hash_table();
@@ -133,6 +197,9 @@ public:
     /// Frees up the memory and allows to continue using the hashtable
     void clear();
 
+    /// Returns the prefilter statistics since construction or the last `clear`; all zeros if the prefilter is disabled
+    filter_stats prefilter_stats();
+
     /**
      * Returns if a key exists in the hash table
      *
@@ -146,8 +213,58 @@ public:
      * Occassionaly, when a certain number of entries are created, rehashing occurs
      *
      * @param value the value to be inserted
+     * @return a handle to the inserted value
+     */
+    handle insert(V value);
+
+    /**
+     * Constructs a value inside the hash table and inserts it like `insert`
+     *
+     * @param args arguments forwarded to the constructor of `V`
+     * @return a handle to the inserted value
+     */
+    template<typename... Args>
+    handle emplace(Args &&... args);
+
+    /**
+     * Constructs a value inside the hash table only if `key` not exists.
+     * The index of the constructed value must be equal to `key`
+     *
+     * @param key the key of the value to be constructed
+     * @param args arguments forwarded to the constructor of `V`
+     * @return a handle to the inserted value or to the first value of `key`, and `true` if the insertion took place
+     * @throws std::runtime_error if the index of the constructed value is not equal to `key`
+     */
+    template<typename... Args>
+    std::pair<handle, bool> try_emplace(K key, Args &&... args);
+
+    /**
+     * Removes a single value. The entry is removed too if it runs out of values
+     *
+     * @param h handle to the value to be deleted
+     */
+    void erase(handle h);
+
+    /**
+     * Removes the values of a key that satisfy a predicate
+     *
+     * @param key the key whose values will be checked
+     * @param pred callable that receives a `const V &` and returns `true` if the value must be deleted
+     * @return the number of deleted values
+     */
+    template<typename Predicate>
+    int erase_value(K key, Predicate pred);
+
+    /**
+     * Modifies a value in place. If the index of the value changes, it is moved to the entry of its new key
+     * and `h` is invalidated
+     *
+     * @param h handle to the value to be modified
+     * @param fn callable that receives a `V &`
+     * @return a handle to the modified value; use it instead of `h` from now on
      */
-    void insert(V value);
+    template<typename Function>
+    handle update(handle h, Function fn);
 
     /**
      * Removes the entry that contains all the values with a determined key
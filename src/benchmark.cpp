@@ -0,0 +1,107 @@
+//
+// Created by agent on 10/19/26.
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "hashfunction.hpp"
+#include "hashtable.cpp"
+
+#ifndef BENCHMARK_N_KEYS
+#define BENCHMARK_N_KEYS 100000
+#endif
+
+#ifndef BENCHMARK_N_QUERIES
+#define BENCHMARK_N_QUERIES 1000000
+#endif
+
+#ifndef BENCHMARK_HIT_RATIO
+#define BENCHMARK_HIT_RATIO 0.05
+#endif
+
+#ifndef BENCHMARK_CHURN_KEYS
+#define BENCHMARK_CHURN_KEYS 1000
+#endif
+
+#ifndef BENCHMARK_CHURN_ROUNDS
+#define BENCHMARK_CHURN_ROUNDS 200000
+#endif
+
+/// Inserts `BENCHMARK_N_KEYS` keys and times `BENCHMARK_N_QUERIES` lookups where most keys are absent
+template<typename Hash>
+void run(const std::string &name, bool prefilter) {
+    std::function<std::string(const std::string &)> index = [](const std::string &s) -> std::string { return s; };
+    hash_table<std::string, std::string, Hash, decltype(index)> hashTable(
+            index, Hash(), std::equal_to<std::string>(), DEFAULT_N_BUCKETS, DEFAULT_MAX_LOAD_FACTOR, prefilter);
+
+    for (int i = 0; i < BENCHMARK_N_KEYS; ++i) {
+        hashTable.insert("account-" + std::to_string(i));
+    }
+
+    int hits_every = (int) (1 / BENCHMARK_HIT_RATIO);
+    int found{};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_N_QUERIES; ++i) {
+        std::string key = (i % hits_every == 0)
+                          ? "account-" + std::to_string(i % BENCHMARK_N_KEYS)
+                          : "unseen-" + std::to_string(i);
+        found += hashTable.find(key);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto stats = hashTable.prefilter_stats();
+    std::cout << name << (prefilter ? " + prefilter" : "") << ": "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms, "
+              << found << " found";
+    if (prefilter) {
+        std::cout << ", " << stats.definite_misses << " definite misses"
+                  << ", observed fpr " << stats.observed_false_positive_rate
+                  << ", estimated fpr " << stats.estimated_false_positive_rate
+                  << ", " << stats.memory_usage << " bytes";
+    }
+    std::cout << std::endl;
+}
+
+/// Keeps `BENCHMARK_CHURN_KEYS` keys alive while inserting and removing keys, then times lookups of absent keys
+void churn() {
+    std::function<std::string(const std::string &)> index = [](const std::string &s) -> std::string { return s; };
+    hash_table<std::string, std::string, std::hash<std::string>, decltype(index)> hashTable(
+            index, std::hash<std::string>(), std::equal_to<std::string>(), DEFAULT_N_BUCKETS, DEFAULT_MAX_LOAD_FACTOR, true);
+
+    for (int i = 0; i < BENCHMARK_CHURN_KEYS; ++i) {
+        hashTable.insert("live-" + std::to_string(i));
+    }
+    for (int i = 0; i < BENCHMARK_CHURN_ROUNDS; ++i) {
+        std::string key = "churn-" + std::to_string(i);
+        hashTable.insert(key);
+        hashTable.remove(key);
+    }
+
+    auto before = hashTable.prefilter_stats();
+    int found{};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_N_QUERIES; ++i) {
+        found += hashTable.find("unseen-" + std::to_string(i));
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto stats = hashTable.prefilter_stats();
+    long long misses = stats.definite_misses - before.definite_misses;
+    long long false_positives = stats.false_positives - before.false_positives;
+    std::cout << "churn (" << hashTable.bucket_count() << " buckets): "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms, "
+              << found << " found, " << misses << " definite misses"
+              << ", observed fpr " << (double) false_positives / (double) (misses + false_positives)
+              << ", estimated fpr " << stats.estimated_false_positive_rate << std::endl;
+}
+
+int main() {
+    run<std::hash<std::string>>("std::hash", false);
+    run<std::hash<std::string>>("std::hash", true);
+    run<sha2::sha256<std::string>>("sha256", false);
+    run<sha2::sha256<std::string>>("sha256", true);
+    churn();
+    return 0;
+}
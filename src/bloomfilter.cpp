@@ -0,0 +1,109 @@
+//
+// Created by agent on 10/19/26.
+//
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "bloomfilter.hpp"
+
+//-----------------------------------------------------------------------------
+
+std::uint64_t bloom_filter::fingerprint(const uint256 &hash_code) {
+    const auto *limbs = hash_code.backend().limbs();
+    std::uint64_t h{};
+
+    for (unsigned i = 0; i < hash_code.backend().size(); ++i) {
+        h ^= static_cast<std::uint64_t>(limbs[i]);
+    }
+
+    // murmur3 finalizer: narrow hashes (e.g. std::hash) still spread over all the bits
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+//-----------------------------------------------------------------------------
+
+std::size_t bloom_filter::block_of(std::uint64_t h) const {
+    return static_cast<std::size_t>(((h >> 32) * static_cast<std::uint64_t>(n_blocks)) >> 32) * block_words;
+}
+
+//-----------------------------------------------------------------------------
+
+bloom_filter::bloom_filter(int capacity, int bits_per_key, int probes)
+        : probes(probes),
+          bits_per_key(bits_per_key),
+          n_blocks(0) {
+    reset(capacity);
+}
+
+//-----------------------------------------------------------------------------
+
+bloom_filter::~bloom_filter() = default;
+
+//-----------------------------------------------------------------------------
+
+void bloom_filter::add(const uint256 &hash_code) {
+    std::uint64_t h = fingerprint(hash_code);
+    std::uint64_t *block = words.data() + block_of(h);
+    std::uint64_t g = h * 0x9e3779b97f4a7c15ULL;
+
+    for (int i = 0; i < probes; ++i) {
+        int bit = (int) (g & (block_bits - 1));
+        block[bit >> 6] |= (1ULL << (bit & 63));
+        g = (g >> 9) | (g << 55);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+bool bloom_filter::may_contain(const uint256 &hash_code) const {
+    std::uint64_t h = fingerprint(hash_code);
+    const std::uint64_t *block = words.data() + block_of(h);
+    std::uint64_t g = h * 0x9e3779b97f4a7c15ULL;
+
+    for (int i = 0; i < probes; ++i) {
+        int bit = (int) (g & (block_bits - 1));
+        if (!(block[bit >> 6] & (1ULL << (bit & 63)))) {
+            return false;
+        }
+        g = (g >> 9) | (g << 55);
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+void bloom_filter::reset(int capacity) {
+    long long bits = (long long) std::max(capacity, 1) * bits_per_key;
+    n_blocks = (int) ((bits + block_bits - 1) / block_bits);
+    words.assign((std::size_t) n_blocks * block_words, 0);
+}
+
+//-----------------------------------------------------------------------------
+
+std::size_t bloom_filter::memory_usage() const {
+    return words.size() * sizeof(std::uint64_t);
+}
+
+//-----------------------------------------------------------------------------
+
+double bloom_filter::false_positive_rate() const {
+    // keys spread unevenly over the blocks, so the rate is averaged per block
+    double rate{};
+    for (int i = 0; i < n_blocks; ++i) {
+        int set_bits{};
+        for (int j = 0; j < block_words; ++j) {
+            set_bits += std::popcount(words[(std::size_t) i * block_words + j]);
+        }
+        rate += std::pow((double) set_bits / block_bits, probes);
+    }
+    return rate / n_blocks;
+}
+
+//-----------------------------------------------------------------------------
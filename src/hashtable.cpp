@@ -15,6 +15,14 @@ hash_table<K, V, Hash, Index, Equal, RehashingFactor>::entry::entry(uint256 hash
 
 //-----------------------------------------------------------------------------
 
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+hash_table<K, V, Hash, Index, Equal, RehashingFactor>::entry::entry(uint256 hash_code, K key)
+        : key(std::move(key)), hash_code(std::move(hash_code)) {
+}
+
+//-----------------------------------------------------------------------------
+
 template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
 requires Constraint<RehashingFactor>
 hash_table<K, V, Hash, Index, Equal, RehashingFactor>::entry::~entry() = default;
@@ -36,23 +44,77 @@ void hash_table<K, V, Hash, Index, Equal, RehashingFactor>::rehashing() {
     int j{};
 
     for (int i = 0; i < b; ++i) {
-        for (entry &e: buckets[i]) {
-            j = (int) (e.hash_code % (b * RehashingFactor));
-            new_buckets[j].push_back(e);
+        // splicing keeps every handle valid
+        while (!buckets[i].empty()) {
+            j = (int) (buckets[i].front().hash_code % (b * RehashingFactor));
+            new_buckets[j].splice(new_buckets[j].end(), buckets[i], buckets[i].begin());
         }
-        buckets[i].clear();
     }
 
     delete[] buckets;
     buckets = new_buckets;
     b *= RehashingFactor;
+    rebuild_filter();
+}
+
+//-----------------------------------------------------------------------------
+
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+void hash_table<K, V, Hash, Index, Equal, RehashingFactor>::rebuild_filter() {
+    if (!filter) {
+        return;
+    }
+
+    filter->reset((int) (b * max_load_factor));
+    filter_stale = 0;
+    for (int i = 0; i < b; ++i) {
+        for (const entry &e: buckets[i]) {
+            filter->add(e.hash_code);
+        }
+    }
 }
 
 //-----------------------------------------------------------------------------
 
 template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
 requires Constraint<RehashingFactor>
-hash_table<K, V, Hash, Index, Equal, RehashingFactor>::hash_table(Index index, Hash hash, Equal equal, int b, float max_load_factor)
+bool hash_table<K, V, Hash, Index, Equal, RehashingFactor>::filter_rejects(const uint256 &hash_code) {
+    if (!filter) {
+        return false;
+    }
+
+    ++filter_queries;
+    if (!filter->may_contain(hash_code)) {
+        ++filter_misses;
+        return true;
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+void hash_table<K, V, Hash, Index, Equal, RehashingFactor>::filter_add(const uint256 &hash_code) {
+    if (!filter) {
+        return;
+    }
+
+    // bloom filters cannot forget keys, so steady churn would fill it up without ever rehashing
+    if (filter_stale >= b * max_load_factor * MAX_FILTER_STALE_FACTOR) {
+        rebuild_filter();
+    } else {
+        filter->add(hash_code);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+hash_table<K, V, Hash, Index, Equal, RehashingFactor>::hash_table(Index index, Hash hash, Equal equal, int b, float max_load_factor,
+                                                                  bool prefilter)
         : index(index),
           b(b),
           v(0),
@@ -60,8 +122,16 @@ hash_table<K, V, Hash, Index, Equal, RehashingFactor>::hash_table(Index index, H
           hash{hash},
           equal{equal},
           max_load_factor(max_load_factor),
-          buckets(nullptr) {
+          buckets(nullptr),
+          filter(std::nullopt),
+          filter_stale(0),
+          filter_queries(0),
+          filter_misses(0),
+          filter_false_hits(0) {
     buckets = new std::list<entry>[b];
+    if (prefilter) {
+        filter.emplace((int) (b * max_load_factor));
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -121,6 +191,14 @@ bool hash_table<K, V, Hash, Index, Equal, RehashingFactor>::empty() {
 template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
 requires Constraint<RehashingFactor>
 void hash_table<K, V, Hash, Index, Equal, RehashingFactor>::clear() {
+    if (filter) {
+        filter->reset((int) (b * max_load_factor));
+        filter_stale = 0;
+        filter_queries = 0;
+        filter_misses = 0;
+        filter_false_hits = 0;
+    }
+
     if (empty()) {
         return;
     }
@@ -134,10 +212,35 @@ void hash_table<K, V, Hash, Index, Equal, RehashingFactor>::clear() {
 
 //-----------------------------------------------------------------------------
 
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+typename hash_table<K, V, Hash, Index, Equal, RehashingFactor>::filter_stats
+hash_table<K, V, Hash, Index, Equal, RehashingFactor>::prefilter_stats() {
+    if (!filter) {
+        return filter_stats{};
+    }
+
+    long long absent = filter_misses + filter_false_hits;
+    return filter_stats{
+            filter_queries,
+            filter_misses,
+            filter_false_hits,
+            absent ? (double) filter_false_hits / (double) absent : 0.0,
+            filter->false_positive_rate(),
+            filter->memory_usage()
+    };
+}
+
+//-----------------------------------------------------------------------------
+
 template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
 requires Constraint<RehashingFactor>
 bool hash_table<K, V, Hash, Index, Equal, RehashingFactor>::find(K key) {
     uint256 hash_code = hash(key);
+    if (filter_rejects(hash_code)) {
+        return false;
+    }
+
     int i = (int) (hash_code % b);
     std::list<entry> &bucket = buckets[i];
 
@@ -146,6 +249,9 @@ bool hash_table<K, V, Hash, Index, Equal, RehashingFactor>::find(K key) {
             return true;
         }
     }
+    if (filter) {
+        ++filter_false_hits;
+    }
     return false;
 }
 
@@ -153,24 +259,161 @@ bool hash_table<K, V, Hash, Index, Equal, RehashingFactor>::find(K key) {
 
 template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
 requires Constraint<RehashingFactor>
-void hash_table<K, V, Hash, Index, Equal, RehashingFactor>::insert(V value) {
-    K key = index(value);
-    uint256 hash_code = hash(key);
+std::pair<typename hash_table<K, V, Hash, Index, Equal, RehashingFactor>::EntryIterator, bool>
+hash_table<K, V, Hash, Index, Equal, RehashingFactor>::locate(const K &key, const uint256 &hash_code) {
     int i = (int) (hash_code % b);
     std::list<entry> &bucket = buckets[i];
 
     EntryIterator it = std::find_if(bucket.begin(), bucket.end(), [&](entry &e) { return equal(e.key, key); });
     if (it != bucket.end()) {
-        it->values.push_front(value);
-    } else {
-        bucket.push_front(entry(hash_code, key, value));
-        ++k;
+        return {it, false};
     }
 
+    bucket.emplace_front(hash_code, key);
+    ++k;
+    filter_add(hash_code);
+    return {bucket.begin(), true};
+}
+
+//-----------------------------------------------------------------------------
+
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+typename hash_table<K, V, Hash, Index, Equal, RehashingFactor>::handle
+hash_table<K, V, Hash, Index, Equal, RehashingFactor>::attach(EntryIterator it, std::list<V> &node) {
+    it->values.splice(it->values.begin(), node);
+    handle h{it, it->values.begin()};
+
     ++v;
     if (load_factor() >= max_load_factor) {
         rehashing();
     }
+    return h;
+}
+
+//-----------------------------------------------------------------------------
+
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+void hash_table<K, V, Hash, Index, Equal, RehashingFactor>::drop_if_empty(EntryIterator it) {
+    if (!it->values.empty()) {
+        return;
+    }
+
+    int i = (int) (it->hash_code % b);
+    buckets[i].erase(it);
+    --k;
+    ++filter_stale;
+}
+
+//-----------------------------------------------------------------------------
+
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+typename hash_table<K, V, Hash, Index, Equal, RehashingFactor>::handle
+hash_table<K, V, Hash, Index, Equal, RehashingFactor>::insert(V value) {
+    std::list<V> node;
+    node.push_front(std::move(value));
+    K key = index(node.front());
+    return attach(locate(key, hash(key)).first, node);
+}
+
+//-----------------------------------------------------------------------------
+
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+template<typename... Args>
+typename hash_table<K, V, Hash, Index, Equal, RehashingFactor>::handle
+hash_table<K, V, Hash, Index, Equal, RehashingFactor>::emplace(Args &&... args) {
+    std::list<V> node;
+    node.emplace_front(std::forward<Args>(args)...);
+    K key = index(node.front());
+    return attach(locate(key, hash(key)).first, node);
+}
+
+//-----------------------------------------------------------------------------
+
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+template<typename... Args>
+std::pair<typename hash_table<K, V, Hash, Index, Equal, RehashingFactor>::handle, bool>
+hash_table<K, V, Hash, Index, Equal, RehashingFactor>::try_emplace(K key, Args &&... args) {
+    auto [it, created] = locate(key, hash(key));
+    if (!created) {
+        return {handle{it, it->values.begin()}, false};
+    }
+
+    std::list<V> node;
+    try {
+        node.emplace_front(std::forward<Args>(args)...);
+    } catch (...) {
+        drop_if_empty(it);
+        throw;
+    }
+
+    if (!equal(index(node.front()), key)) {
+        drop_if_empty(it);
+        throw std::runtime_error("the index of the constructed value is not equal to \"key\"");
+    }
+    return {attach(it, node), true};
+}
+
+//-----------------------------------------------------------------------------
+
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+void hash_table<K, V, Hash, Index, Equal, RehashingFactor>::erase(handle h) {
+    h.entry->values.erase(h.value);
+    --v;
+    drop_if_empty(h.entry);
+}
+
+//-----------------------------------------------------------------------------
+
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+template<typename Predicate>
+int hash_table<K, V, Hash, Index, Equal, RehashingFactor>::erase_value(K key, Predicate pred) {
+    uint256 hash_code = hash(key);
+    if (filter_rejects(hash_code)) {
+        return 0;
+    }
+
+    int i = (int) (hash_code % b);
+    std::list<entry> &bucket = buckets[i];
+
+    EntryIterator it = std::find_if(bucket.begin(), bucket.end(), [&](entry &e) { return equal(e.key, key); });
+    if (it == bucket.end()) {
+        if (filter) {
+            ++filter_false_hits;
+        }
+        return 0;
+    }
+
+    int n = (int) it->values.remove_if([&](const V &value) { return pred(value); });
+    v -= n;
+    drop_if_empty(it);
+    return n;
+}
+
+//-----------------------------------------------------------------------------
+
+template<typename K, typename V, typename Hash, typename Index, typename Equal, uint8 RehashingFactor>
+requires Constraint<RehashingFactor>
+template<typename Function>
+typename hash_table<K, V, Hash, Index, Equal, RehashingFactor>::handle
+hash_table<K, V, Hash, Index, Equal, RehashingFactor>::update(handle h, Function fn) {
+    fn(*h.value);
+    K key = index(*h.value);
+    if (equal(h.entry->key, key)) {
+        return h;
+    }
+
+    std::list<V> node;
+    node.splice(node.begin(), h.entry->values, h.value);
+    --v;
+    drop_if_empty(h.entry);
+    return attach(locate(key, hash(key)).first, node);
 }
 
 //-----------------------------------------------------------------------------
@@ -179,6 +422,10 @@ template<typename K, typename V, typename Hash, typename Index, typename Equal,
 requires Constraint<RehashingFactor>
 bool hash_table<K, V, Hash, Index, Equal, RehashingFactor>::remove(K key) {
     uint256 hash_code = hash(key);
+    if (filter_rejects(hash_code)) {
+        return false;
+    }
+
     int i = (int) (hash_code % b);
     std::list<entry> &bucket = buckets[i];
 
@@ -186,9 +433,13 @@ bool hash_table<K, V, Hash, Index, Equal, RehashingFactor>::remove(K key) {
     if (it != bucket.end()) {
         v -= it->values.size();
         --k;
+        ++filter_stale;
         bucket.erase(it);
         return true;
     }
+    if (filter) {
+        ++filter_false_hits;
+    }
     return false;
 }
 
@@ -198,6 +449,10 @@ template<typename K, typename V, typename Hash, typename Index, typename Equal,
 requires Constraint<RehashingFactor>
 std::list<V> hash_table<K, V, Hash, Index, Equal, RehashingFactor>::search(K key) {
     uint256 hash_code = hash(key);
+    if (filter_rejects(hash_code)) {
+        return std::list<V>{};
+    }
+
     int i = (int) (hash_code % b);
     std::list<entry> &bucket = buckets[i];
 
@@ -206,6 +461,9 @@ std::list<V> hash_table<K, V, Hash, Index, Equal, RehashingFactor>::search(K key
             return e.values;
         }
     }
+    if (filter) {
+        ++filter_false_hits;
+    }
     return std::list<V>{};
 }
 
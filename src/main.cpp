@@ -7,7 +7,7 @@
 
 int main() {
     sha2::sha256<std::string> hash;
-    std::function<std::string(transaction *)> index = [&](const transaction *tx) -> std::string {
+    std::function<std::string(transaction *const &)> index = [&](const transaction *tx) -> std::string {
         return tx->emisor;
     };
     std::function<bool(std::string, std::string)> equal = [&](const std::string &a, const std::string &b) -> bool {
@@ -38,6 +38,13 @@ int main() {
         std::cout << std::endl;
     }
 
+    int cancelled = hashTable.erase_value(key, [](const transaction *tx) { return tx->amount > 70000; });
+    std::cout << cancelled << " transactions cancelled:" << std::endl;
+    for (const transaction *t: hashTable.search(key)) {
+        std::cout << t->to_string() << std::endl;
+    }
+    std::cout << std::endl;
+
     if (hashTable.remove(key)) {
         std::cout << "key removed:" << std::endl;
         hashTable.print(std::cout, [&](std::ostream &os, const transaction *tx) { os << *tx; });
@@ -0,0 +1,149 @@
+//
+// Created by agent on 10/19/26.
+//
+
+#include <iostream>
+#include <string>
+
+#include "hashtable.cpp"
+
+/// Value that counts its copies
+struct record {
+
+    std::string key;                //< The index of the record
+    int amount;                     //< Any payload
+
+    static inline int copies = 0;   //< Number of copies made since the last reset
+
+    record(std::string key, int amount) : key(std::move(key)), amount(amount) {}
+
+    record(const record &r) : key(r.key), amount(r.amount) { ++copies; }
+
+    record(record &&r) noexcept = default;
+
+};
+
+using table = hash_table<std::string, record>;
+
+int failures = 0;
+
+/// Reports a failed check without aborting the remaining ones
+void check(bool condition, const std::string &what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+table make(bool prefilter) {
+    return table([](const record &r) { return r.key; }, std::hash<std::string>(), std::equal_to<std::string>(),
+                 DEFAULT_N_BUCKETS, DEFAULT_MAX_LOAD_FACTOR, prefilter);
+}
+
+void handle_survives_rehashing(bool prefilter) {
+    table t = make(prefilter);
+    auto h = t.emplace("first", 1);
+    int buckets = t.bucket_count();
+    for (int i = 0; i < 1000; ++i) {
+        t.emplace("key-" + std::to_string(i), i);
+    }
+
+    check(t.bucket_count() > buckets, "rehashing occurs");
+    check(h->key == "first" && h->amount == 1, "handle keeps its value after rehashing");
+    t.erase(h);
+    check(!t.find("first") && t.key_count() == 1000 && t.size() == 1000, "erase through a rehashed handle");
+}
+
+void update_moves_value(bool prefilter) {
+    table t = make(prefilter);
+    t.emplace("a", 1);
+    auto h = t.emplace("b", 2);
+
+    h = t.update(h, [](record &r) { r.amount = 3; });
+    check(h->amount == 3 && t.search("b").front().amount == 3, "update without key change modifies in place");
+
+    h = t.update(h, [](record &r) { r.key = "a"; });
+    check(!t.find("b"), "update drops the emptied entry");
+    check(t.key_count() == 1 && t.size() == 2 && t.search("a").size() == 2, "update moves the value to its new key");
+    check(h->key == "a" && h->amount == 3, "update returns a handle to the moved value");
+
+    t.erase(h);
+    check(t.size() == 1 && t.search("a").front().amount == 1, "erase through the handle returned by update");
+}
+
+void try_emplace_checks_key(bool prefilter) {
+    table t = make(prefilter);
+    t.emplace("a", 1);
+
+    bool thrown = false;
+    try {
+        t.try_emplace("mismatch", "other", 2);
+    } catch (std::runtime_error &) {
+        thrown = true;
+    }
+    check(thrown, "try_emplace throws on index mismatch");
+    check(t.key_count() == 1 && t.size() == 1 && !t.find("mismatch") && !t.find("other"),
+          "try_emplace rolls back on index mismatch");
+
+    auto [existing, inserted] = t.try_emplace("a", "a", 3);
+    check(!inserted && existing->amount == 1 && t.size() == 1, "try_emplace keeps an existing key");
+
+    auto [created, ok] = t.try_emplace("c", "c", 4);
+    check(ok && created->amount == 4 && t.find("c") && t.key_count() == 2, "try_emplace inserts a new key");
+}
+
+void erase_last_value(bool prefilter) {
+    table t = make(prefilter);
+    auto h = t.emplace("a", 1);
+    auto g = t.emplace("a", 2);
+
+    t.erase(g);
+    check(t.find("a") && t.size() == 1, "erase keeps an entry with values left");
+    t.erase(h);
+    check(!t.find("a") && t.key_count() == 0 && t.empty(), "erase of the last value removes its entry");
+}
+
+void erase_value_matches(bool prefilter) {
+    table t = make(prefilter);
+    for (int i = 0; i < 10; ++i) {
+        t.emplace("a", i);
+    }
+
+    check(t.erase_value("a", [](const record &r) { return r.amount % 2 == 0; }) == 5, "erase_value count");
+    check(t.size() == 5 && t.search("a").size() == 5, "erase_value keeps the other values");
+    check(t.erase_value("missing", [](const record &) { return true; }) == 0, "erase_value on a missing key");
+    check(t.erase_value("a", [](const record &) { return true; }) == 5 && !t.find("a"),
+          "erase_value drops the emptied entry");
+}
+
+void nothing_is_copied(bool prefilter) {
+    table t = make(prefilter);
+    record::copies = 0;
+
+    t.insert(record("a", 1));
+    auto h = t.emplace("a", 2);
+    t.try_emplace("b", "b", 3);
+    h = t.update(h, [](record &r) { r.key = "c"; });
+    t.erase_value("a", [](const record &) { return true; });
+    t.erase(h);
+
+    check(record::copies == 0, "no value is copied");
+}
+
+int main() {
+    for (bool prefilter: {false, true}) {
+        handle_survives_rehashing(prefilter);
+        update_moves_value(prefilter);
+        try_emplace_checks_key(prefilter);
+        erase_last_value(prefilter);
+        erase_value_matches(prefilter);
+        nothing_is_copied(prefilter);
+    }
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}